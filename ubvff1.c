@@ -97,6 +97,82 @@ int roundInt(int n, int d) {	// will round down if within 25% of divisor, otherw
 	return l-1;
 }
 
+//----------------------------------------------------------------------------
+//  FAST OUTPUT - FIXED POINT FORMATTER AND BUFFERED WRITER
+//----------------------------------------------------------------------------
+
+#define OUTPUT_BUFSIZE 65536		// stdio buffer size for svg and json output files
+
+int setOutputBuffer(FILE * fout) {
+	// give the output file a large buffer, so it is written in a few big chunks
+	if(setvbuf(fout, NULL, _IOFBF, OUTPUT_BUFSIZE) != 0) {
+		printf("warning : setvbuf failed, using default output buffering\n");
+		return 1;
+	}
+	return 0;
+}
+
+int formatUInt(char * dest, uint32_t n) {
+	// write n in decimal (no terminator), return number of chars written
+	char tmp[10];
+	int len = 0;
+	do {
+		tmp[len++] = '0' + (n % 10);
+		n /= 10;
+	} while(n);
+	for(int i=0; i<len; i++) {
+		dest[i] = tmp[len-1-i];
+	}
+	return len;
+}
+
+int formatFixed(char * dest, int32_t x) {
+	// same output as sprintf(dest, F_FLOAT_FORMAT, (double)x/(double)scaleFactor), but integer only
+	// rounds half to even, like printf, so the output is identical
+	int pos = 0;
+	uint32_t mag = (uint32_t)x;
+	if(x<0) {
+		dest[pos++] = '-';
+		mag = 0 - mag;
+	}
+	uint32_t whole = mag / scaleFactor;
+	uint64_t t = (uint64_t)(mag % scaleFactor) * 1000000;
+	uint32_t frac = t / scaleFactor;
+	uint32_t rem = t % scaleFactor;
+	if(rem*2 > scaleFactor || (rem*2 == scaleFactor && (frac & 1))) {
+		frac++;
+		if(frac == 1000000) {
+			frac = 0;
+			whole++;
+		}
+	}
+	pos += formatUInt(&dest[pos], whole);
+	dest[pos++] = '.';
+	for(int i=6; i>0; i--) {
+		dest[pos+i-1] = '0' + (frac % 10);
+		frac /= 10;
+	}
+	pos += 6;
+	dest[pos] = 0;
+	return pos;
+}
+
+int formatPoint(char * dest, struct BIN_POINT * p, char sep) {
+	// "x y" or "x,y", return number of chars written
+	int pos = formatFixed(dest, p->x);
+	dest[pos++] = sep;
+	pos += formatFixed(&dest[pos], p->y);
+	return pos;
+}
+
+int writeOutput(FILE * fout, char * buf, int len, char * caller) {
+	if(fwrite(buf, 1, len, fout) != len) {
+		printf("\nerror : fwrite failed (%s)\n", caller);
+		return 1;
+	}
+	return 0;
+}
+
 //----------------------------------------------------------------------------
 //  SVG OUTPUT - GLOBAL VARIABLES AND FUNCTIONS
 //----------------------------------------------------------------------------
@@ -156,24 +232,21 @@ int dumpSVGStartLayer(FILE * fout) {
 
 int dumpSVGStartPath(FILE * fout, struct BIN_POINT * p) {
 	if(!svgdump) return 0;
-	char base[20] = "";
+	char buf[64] = "";
+	int pos;
 	if(svgDumpState == DUMPSTATE_AFTER_CLOSE_PATH || svgDumpState == DUMPSTATE_AFTER_LINE) {
-		sprintf(base,"%s","M ");
+		pos = sprintf(buf,"%s","M ");
 	}	
 	else if(svgDumpState != DUMPSTATE_AFTER_START_LAYER && svgDumpState != DUMPSTATE_AFTER_END_PATH) {
 		printf("\nstate error : in dumpSVGStartPath: %d\n",svgDumpState);
 		return 1;
 	} else {
-		sprintf(base,"%s","<path d=\"M ");
+		pos = sprintf(buf,"%s","<path d=\"M ");
 	}
 		
-	int r = fprintf(fout, "%s" F_FLOAT_FORMAT " " F_FLOAT_FORMAT " ",
-		base,
-		(double)p->x/(double)scaleFactor,
-		(double)p->y/(double)scaleFactor);
-	//
-	if(r < 0) {
-		printf("\nerror : fprintf failed (dumpSVGStartPath)\n");
+	pos += formatPoint(&buf[pos], p, ' ');
+	buf[pos++] = ' ';
+	if(writeOutput(fout, buf, pos, "dumpSVGStartPath")) {
 		return 1;
 	}	
 	svgDumpState = DUMPSTATE_AFTER_START_PATH;
@@ -186,13 +259,14 @@ int dumpSVGCubic(FILE * fout, struct BIN_CUBIC * c) {
 		printf("\nstate error : in dumpSVGCubic: %d\n", svgDumpState);
 		return 1;
 	}
-	int r = fprintf(fout, "C " F_FLOAT_FORMAT " " F_FLOAT_FORMAT ", " F_FLOAT_FORMAT " " F_FLOAT_FORMAT ", " F_FLOAT_FORMAT " " F_FLOAT_FORMAT " ", 
-		(double)c->p[0].x/(double)scaleFactor, (double)c->p[0].y/(double)scaleFactor,
-		(double)c->p[1].x/(double)scaleFactor, (double)c->p[1].y/(double)scaleFactor,
-		(double)c->p[2].x/(double)scaleFactor, (double)c->p[2].y/(double)scaleFactor);
-	//
-	if(r < 0) {
-		printf("\nerror : fprintf failed (dumpSVGCubic)\n");
+	char buf[128] = "C ";
+	int pos = 2;
+	for(int i=0; i<3; i++) {
+		pos += formatPoint(&buf[pos], &c->p[i], ' ');
+		if(i<2) buf[pos++] = ',';
+		buf[pos++] = ' ';
+	}
+	if(writeOutput(fout, buf, pos, "dumpSVGCubic")) {
 		return 1;
 	}		
 	svgDumpState = DUMPSTATE_AFTER_LINE;
@@ -205,9 +279,11 @@ int dumpSVGLine(FILE * fout, struct BIN_POINT * p) {
 		printf("\nstate error : in dumpSVGLine: %d\n",svgDumpState);
 		return 1;
 	}
-	int r = fprintf(fout, "L " F_FLOAT_FORMAT " " F_FLOAT_FORMAT " ", (double)p->x/(double)scaleFactor, (double)p->y/(double)scaleFactor);
-	if(r < 0) {
-		printf("\nfprintf failed (dumpSVGLine)\n");
+	char buf[64] = "L ";
+	int pos = 2;
+	pos += formatPoint(&buf[pos], p, ' ');
+	buf[pos++] = ' ';
+	if(writeOutput(fout, buf, pos, "dumpSVGLine")) {
 		return 1;
 	}			
 	svgDumpState = DUMPSTATE_AFTER_LINE;
@@ -245,9 +321,11 @@ int dumpSVGEndPath(FILE * fout, int hasFill, struct BIN_COLOR * fillColor, int h
 	}
 	
 	if(hasStroke) { 
-		sprintf(strokeBuf,"stroke=\"rgb(%u,%u,%u)\" stroke-width=\"" F_FLOAT_FORMAT "\" stroke-linecap=\"butt\" stroke-linejoin=\"miter\" stroke-miterlimit=\"10\" ",
+		char widthBuf[20];
+		formatFixed(widthBuf, strokeWidth);
+		sprintf(strokeBuf,"stroke=\"rgb(%u,%u,%u)\" stroke-width=\"%s\" stroke-linecap=\"butt\" stroke-linejoin=\"miter\" stroke-miterlimit=\"10\" ",
 			strokeColor->r, strokeColor->g, strokeColor->b,
-			(double)strokeWidth/(double)scaleFactor
+			widthBuf
 		);
 	}
 	
@@ -377,6 +455,219 @@ int escapeStringA(char * dest, int destSize, char * source) {
 	return overflow;
 }
 
+//----------------------------------------------------------------------------
+//  JSON-LINES OUTPUT - GLOBAL VARIABLES AND FUNCTIONS
+//----------------------------------------------------------------------------
+
+/*	One JSON object per path, one path per line, e.g.
+	{"layer":0,"name":"Layer 1","d":[["M",x,y],["L",x,y],["C",x1,y1,x2,y2,x,y],["Z"]],
+	 "fill":[r,g,b],"stroke":[r,g,b],"strokeWidth":w}
+	fill, stroke and strokeWidth are null when not present.
+	Coordinates are fixed decimals, identical to those in the svg output. */
+
+int jsondump = 0;
+
+enum SVGDUMP_STATE jsonDumpState = 0;	// same states as the svg output (header is not used)
+
+int jsonLayer = -1;						// index of current layer
+char jsonLayerName[6*65] = "";			// escaped name of current layer
+
+int escapeStringJSON(char * dest, int destSize, char * source) {
+	// Escape for use inside a JSON string. Bytes above 126 are treated as Latin-1.
+	// Returns 1 on overflow (output is truncated but still terminated).
+	int destPos = 0;
+	
+	if(destSize<1) return 1;
+	
+	for(int i=0; source[i]!=0; i++) {
+		uint8_t c = (uint8_t)source[i];
+		if(c < 32 || c > 126) {
+			if(destPos+6 >= destSize) {
+				dest[destPos] = 0;
+				return 1;
+			}
+			sprintf(&dest[destPos],"\\u%04X",c);
+			destPos+=6;
+		} else {
+			if(destPos+2 >= destSize) {
+				dest[destPos] = 0;
+				return 1;
+			}
+			if(c=='\\' || c=='"') {
+				dest[destPos++] = '\\';
+			}
+			dest[destPos++] = c;
+		}
+	}
+	dest[destPos] = 0;
+	return 0;
+}
+
+int formatColorJSON(char * dest, int hasColor, struct BIN_COLOR * color) {
+	if(!hasColor) return sprintf(dest,"null");
+	return sprintf(dest,"[%u,%u,%u]",color->r,color->g,color->b);
+}
+
+int dumpJSONStartLayer(FILE * fout, char * title) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_BEGIN && jsonDumpState != DUMPSTATE_AFTER_END_LAYER) {
+		printf("\nstate error : in dumpJSONStartLayer: %d\n", jsonDumpState);
+		return 1;
+	}
+	if(escapeStringJSON(jsonLayerName, sizeof(jsonLayerName), title)) {
+		printf("\nerror : layer name overflow (dumpJSONStartLayer)\n");
+		return 1;
+	}
+	jsonLayer++;
+	jsonDumpState = DUMPSTATE_AFTER_START_LAYER;
+	return 0;
+}
+
+int dumpJSONStartPath(FILE * fout, struct BIN_POINT * p) {
+	if(!jsondump) return 0;
+	char buf[sizeof(jsonLayerName)+128];
+	int pos;
+	if(jsonDumpState == DUMPSTATE_AFTER_CLOSE_PATH || jsonDumpState == DUMPSTATE_AFTER_LINE) {
+		pos = sprintf(buf,"%s",",[\"M\",");
+	}
+	else if(jsonDumpState != DUMPSTATE_AFTER_START_LAYER && jsonDumpState != DUMPSTATE_AFTER_END_PATH) {
+		printf("\nstate error : in dumpJSONStartPath: %d\n",jsonDumpState);
+		return 1;
+	} else {
+		pos = sprintf(buf,"{\"layer\":%d,\"name\":\"%s\",\"d\":[[\"M\",",jsonLayer,jsonLayerName);
+	}
+	pos += formatPoint(&buf[pos], p, ',');
+	buf[pos++] = ']';
+	if(writeOutput(fout, buf, pos, "dumpJSONStartPath")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_START_PATH;
+	return 0;
+}
+
+int dumpJSONCubic(FILE * fout, struct BIN_CUBIC * c) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_START_PATH && jsonDumpState != DUMPSTATE_AFTER_LINE) {
+		printf("\nstate error : in dumpJSONCubic: %d\n", jsonDumpState);
+		return 1;
+	}
+	char buf[128] = ",[\"C\"";
+	int pos = 5;
+	for(int i=0; i<3; i++) {
+		buf[pos++] = ',';
+		pos += formatPoint(&buf[pos], &c->p[i], ',');
+	}
+	buf[pos++] = ']';
+	if(writeOutput(fout, buf, pos, "dumpJSONCubic")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_LINE;
+	return 0;
+}
+
+int dumpJSONLine(FILE * fout, struct BIN_POINT * p) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_START_PATH && jsonDumpState != DUMPSTATE_AFTER_LINE) {
+		printf("\nstate error : in dumpJSONLine: %d\n",jsonDumpState);
+		return 1;
+	}
+	char buf[64] = ",[\"L\",";
+	int pos = 6;
+	pos += formatPoint(&buf[pos], p, ',');
+	buf[pos++] = ']';
+	if(writeOutput(fout, buf, pos, "dumpJSONLine")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_LINE;
+	return 0;
+}
+
+int dumpJSONClosePath(FILE * fout) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_LINE) {
+		printf("\nstate error : in dumpJSONClosePath: %d\n",jsonDumpState);
+		return 1;
+	}
+	if(writeOutput(fout, ",[\"Z\"]", 6, "dumpJSONClosePath")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_CLOSE_PATH;
+	return 0;
+}
+
+int dumpJSONEndPath(FILE * fout, int hasFill, struct BIN_COLOR * fillColor, int hasStroke, int32_t strokeWidth, struct BIN_COLOR * strokeColor) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_LINE && jsonDumpState != DUMPSTATE_AFTER_CLOSE_PATH) {
+		printf("\nstate error : in dumpJSONEndPath: %d\n",jsonDumpState);
+		return 1;
+	}
+	char buf[128];
+	int pos = sprintf(buf,"%s","],\"fill\":");
+	pos += formatColorJSON(&buf[pos], hasFill, fillColor);
+	pos += sprintf(&buf[pos],"%s",",\"stroke\":");
+	pos += formatColorJSON(&buf[pos], hasStroke, strokeColor);
+	pos += sprintf(&buf[pos],"%s",",\"strokeWidth\":");
+	if(hasStroke) {
+		pos += formatFixed(&buf[pos], strokeWidth);
+	} else {
+		pos += sprintf(&buf[pos],"null");
+	}
+	pos += sprintf(&buf[pos],"%s","}\n");
+	if(writeOutput(fout, buf, pos, "dumpJSONEndPath")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_END_PATH;
+	return 0;
+}
+
+int dumpJSONEndLayer(FILE * fout) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_END_PATH && jsonDumpState != DUMPSTATE_AFTER_START_LAYER) {
+		printf("\nstate error : in dumpJSONEndLayer: %d\n",jsonDumpState);
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_END_LAYER;
+	return 0;
+}
+
+int dumpJSONFooter(FILE * fout) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_END_LAYER) {
+		printf("\nstate error : in dumpJSONFooter: %d\n",jsonDumpState);
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_FOOTER;
+	return 0;
+}
+
+//----------------------------------------------------------------------------
+//  AUTO FILENAME
+//----------------------------------------------------------------------------
+
+int makeAutoFilename(char * dest, int destSize, char * source, char * ext) {
+	// Replace a short trailing extension of source (if any) with ext, e.g. ".svg"
+	if(strlen(source)+1 > destSize) return 1;
+	strcpy(dest, source);
+	// remove common trailing extensions for common file names
+	int s = strlen(dest);
+	if(s>5) {
+		int dotPos=-1;
+		for(int i=s-5; i<s; i++) {
+			if(dest[i]=='/' || dest[i]=='\\') dotPos=-1;
+			else if(dest[i]=='.') dotPos=i;
+		}
+		if(dotPos != -1) {
+			dest[dotPos] = 0;
+		}
+	}
+	s = strlen(dest);
+	if((s+strlen(ext)+1) < destSize) {
+		strcpy(&dest[s],ext);
+		return 0;
+	}
+	return 1;
+}
+
 //----------------------------------------------------------------------------
 //  MAIN
 //----------------------------------------------------------------------------
@@ -385,9 +676,10 @@ int main(int argc, char * argv[]) {
     
     if(argc<2) {
 		printf("%s","ubvff1: Unknown Binary Vector File Format Type 1, analyser and SVG converter.\n\n");
-		printf("%s","usage: ubvff1 inputFile [-svgdump outputFile] [-more] [-less]\n"
+		printf("%s","usage: ubvff1 inputFile [-svgdump outputFile] [-jsondump outputFile] [-more] [-less]\n"
 					"    inputFile              File name of compatible input file.\n"
 					"    -svgdump ouputFile     Create an svg file. Can be \"auto\".\n"
+					"    -jsondump outputFile   Create a JSON-lines file, one path per line. Can be \"auto\".\n"
 					"    -more                  Display more analysis information.\n"
 					"    -less                  Display less analysis information.\n"
 		);
@@ -396,8 +688,10 @@ int main(int argc, char * argv[]) {
     
 	char * filename = argv[1];
 	char * svgfilename = "";
+	char * jsonfilename = "";
 	int detail = 2;					// 1:little, 2:one line per command, 3:all
-	char autoFilename[300];			// this needs to exist in this scope
+	char autoFilename[300];			// these need to exist in this scope
+	char autoJSONFilename[300];
 	
 	if(strlen(argv[1]) > (sizeof(autoFilename)-10)) {
 		printf("error : input file name is too long\n");
@@ -409,6 +703,10 @@ int main(int argc, char * argv[]) {
 			svgdump = 1;
 			i++;
 			svgfilename = argv[i];
+		} else if(strncmp(argv[i],"-jsondump",9)==0 && i<(argc-1)) {
+			jsondump = 1;
+			i++;
+			jsonfilename = argv[i];
 		} else if(strncmp(argv[i],"-more",5)==0) {
 			detail++;
 		} else if(strncmp(argv[i],"-less",5)==0) {
@@ -426,32 +724,17 @@ int main(int argc, char * argv[]) {
     fseek(f,0,SEEK_SET);
 
 	FILE * fout = NULL;
+	FILE * jout = NULL;
 	
 	// open output file if we are dumping
 	if(svgdump) {
 		// come up with auto svg filename
 		if(memcmp(svgfilename,"auto",5)==0) {
-			strcpy(autoFilename, filename);
-			// remove common trailing extensions for common file names
-			int s = strlen(autoFilename);
-			if(s>5) {
-				int dotPos=-1;
-				for(int i=s-5; i<s; i++) {
-					if(autoFilename[i]=='/' || autoFilename[i]=='\\') dotPos=-1;
-					else if(autoFilename[i]=='.') dotPos=i;
-				}
-				if(dotPos != -1) {
-					autoFilename[dotPos] = 0;
-				}
-			}
-			s = strlen(autoFilename);
-			if((s+5) < sizeof(autoFilename)) {
-				memcpy(&autoFilename[s],".svg",5);
-				svgfilename = autoFilename;
-			} else {
+			if(makeAutoFilename(autoFilename, sizeof(autoFilename), filename, ".svg")) {
 				printf("error : auto filename is too long\n");
 				return 1;
 			}
+			svgfilename = autoFilename;
 		}
 
 		// Open output file
@@ -460,9 +743,30 @@ int main(int argc, char * argv[]) {
 			printf("error : unable to open output file: %s\n", svgfilename);
 			return 1;
 		}
+		setOutputBuffer(fout);
 		printf("dumping SVG to : %s\n", svgfilename);
 	}
 
+	if(jsondump) {
+		// come up with auto json filename
+		if(memcmp(jsonfilename,"auto",5)==0) {
+			if(makeAutoFilename(autoJSONFilename, sizeof(autoJSONFilename), filename, ".jsonl")) {
+				printf("error : auto filename is too long\n");
+				return 1;
+			}
+			jsonfilename = autoJSONFilename;
+		}
+
+		// Open output file
+		jout = fopen(jsonfilename,"wb");
+		if(jout==NULL) {
+			printf("error : unable to open output file: %s\n", jsonfilename);
+			return 1;
+		}
+		setOutputBuffer(jout);
+		printf("dumping JSON to : %s\n", jsonfilename);
+	}
+
 	// States read from input file	
 	char title[65]="";
 	struct BIN_COLOR color;
@@ -523,7 +827,7 @@ int main(int argc, char * argv[]) {
 					break;
 				}
 			}
-			if(dumpSVGStartLayer(fout)) {
+			if(dumpSVGStartLayer(fout) || dumpJSONStartLayer(jout,title)) {
 				break;
 			}
 		} else if(cmd==0x02) {						// CMD_02_END_LAYER
@@ -534,7 +838,12 @@ int main(int argc, char * argv[]) {
 					break;
 				}
 			}
-			if(dumpSVGEndLayer(fout)) {
+			if(jsonDumpState == DUMPSTATE_AFTER_CLOSE_PATH) {
+				if(dumpJSONEndPath(jout,0,&color,0,strokeWidth,&strokeColor)) {
+					break;
+				}
+			}
+			if(dumpSVGEndLayer(fout) || dumpJSONEndLayer(jout)) {
 				break;
 			}
 		} else if(cmd==0x03) {						// CMD_03_START_FILE
@@ -572,7 +881,7 @@ int main(int argc, char * argv[]) {
 				printFloat(p.y);
 				printf("\n");
 			}
-			if(dumpSVGStartPath(fout,&p)) {
+			if(dumpSVGStartPath(fout,&p) || dumpJSONStartPath(jout,&p)) {
 				break;
 			}
 		} else if(cmd==0x07) { 						// CMD_07_LINE
@@ -598,7 +907,7 @@ int main(int argc, char * argv[]) {
 				} else if(y < 2 && detail >= 2) {
 					printf("...");
 				}
-				if(dumpSVGLine(fout,&p)) {
+				if(dumpSVGLine(fout,&p) || dumpJSONLine(jout,&p)) {
 					break;
 				}
 			}
@@ -628,25 +937,25 @@ int main(int argc, char * argv[]) {
 				} else if(y<2 && detail >= 2) {
 					printf("...");
 				}
-				if(dumpSVGCubic(fout,&c)) {
+				if(dumpSVGCubic(fout,&c) || dumpJSONCubic(jout,&c)) {
 					break;
 				}
 			}
 			if(detail >= 2) printf("\n");
 		} else if(cmd==0x09) {						// CMD_09_END_PATH_SO
 			if(detail >= 2) printf("\n");
-			if(dumpSVGEndPath(fout,0,&color,1,strokeWidth,&strokeColor)) {
+			if(dumpSVGEndPath(fout,0,&color,1,strokeWidth,&strokeColor) || dumpJSONEndPath(jout,0,&color,1,strokeWidth,&strokeColor)) {
 				break; /* TODO: might need to fix fill color ???? */
 			}
 		} else if(cmd==0x0A || cmd==0x0B) { 		// CMD_0A_END_PATH_FO or CMD_OB_END_PATH_SF */
-			if(dumpSVGEndPath(fout,1,&color,(cmd==0x0B),strokeWidth,&strokeColor)) {
+			if(dumpSVGEndPath(fout,1,&color,(cmd==0x0B),strokeWidth,&strokeColor) || dumpJSONEndPath(jout,1,&color,(cmd==0x0B),strokeWidth,&strokeColor)) {
 				break;
 			}
 			if(detail >= 2) printf("\n");
 		} else if(cmd==0x0C) { 						// CMD_0C_NOP
 			if(detail >= 2) printf("\n");
 		} else if(cmd==0x0D) { 						// CMD_0D_CLOSE_PATH
-			if(dumpSVGClosePath(fout)) {
+			if(dumpSVGClosePath(fout) || dumpJSONClosePath(jout)) {
 				break;
 			}
 			if(detail >= 2) printf("\n");
@@ -675,7 +984,7 @@ int main(int argc, char * argv[]) {
 			}
 		} else if(cmd==0x15) { 						// CMD_15_END_FILE
 			if(detail >= 2) printf("\n");
-			if(dumpSVGFooter(fout)) {
+			if(dumpSVGFooter(fout) || dumpJSONFooter(jout)) {
 				break;
 			}
 			break; 		// we've finished
@@ -698,10 +1007,23 @@ int main(int argc, char * argv[]) {
 			error = 1;
 		}
 	}
+
+	if(jsondump && jsonDumpState!=DUMPSTATE_AFTER_FOOTER) {
+		error = 1;
+	}
 	
 	fclose(f);
 	if(svgdump) {
-		fclose(fout);
+		if(fclose(fout) != 0) {			// output is buffered, so write errors may only show up here
+			printf("error : failed writing svg output file\n");
+			error = 1;
+		}
+	}
+	if(jsondump) {
+		if(fclose(jout) != 0) {
+			printf("error : failed writing json output file\n");
+			error = 1;
+		}
 	}
 	
 	if(error) {
@@ -107,6 +107,82 @@ void printFloat(int32_t x) {
 
 #define F_FLOAT_FORMAT "%.6f"
 
+//----------------------------------------------------------------------------
+//  FAST OUTPUT - FIXED POINT FORMATTER AND BUFFERED WRITER
+//----------------------------------------------------------------------------
+
+#define OUTPUT_BUFSIZE 65536		// stdio buffer size for svg and json output files
+
+int setOutputBuffer(FILE * fout) {
+	// give the output file a large buffer, so it is written in a few big chunks
+	if(setvbuf(fout, NULL, _IOFBF, OUTPUT_BUFSIZE) != 0) {
+		printf("warning : setvbuf failed, using default output buffering\n");
+		return 1;
+	}
+	return 0;
+}
+
+int formatUInt(char * dest, uint32_t n) {
+	// write n in decimal (no terminator), return number of chars written
+	char tmp[10];
+	int len = 0;
+	do {
+		tmp[len++] = '0' + (n % 10);
+		n /= 10;
+	} while(n);
+	for(int i=0; i<len; i++) {
+		dest[i] = tmp[len-1-i];
+	}
+	return len;
+}
+
+int formatFixed(char * dest, int32_t x) {
+	// same output as sprintf(dest, F_FLOAT_FORMAT, (double)x/(double)scaleFactor), but integer only
+	// rounds half to even, like printf, so the output is identical
+	int pos = 0;
+	uint32_t mag = (uint32_t)x;
+	if(x<0) {
+		dest[pos++] = '-';
+		mag = 0 - mag;
+	}
+	uint32_t whole = mag / scaleFactor;
+	uint64_t t = (uint64_t)(mag % scaleFactor) * 1000000;
+	uint32_t frac = t / scaleFactor;
+	uint32_t rem = t % scaleFactor;
+	if(rem*2 > scaleFactor || (rem*2 == scaleFactor && (frac & 1))) {
+		frac++;
+		if(frac == 1000000) {
+			frac = 0;
+			whole++;
+		}
+	}
+	pos += formatUInt(&dest[pos], whole);
+	dest[pos++] = '.';
+	for(int i=6; i>0; i--) {
+		dest[pos+i-1] = '0' + (frac % 10);
+		frac /= 10;
+	}
+	pos += 6;
+	dest[pos] = 0;
+	return pos;
+}
+
+int formatPoint(char * dest, struct BIN_POINT * p, char sep) {
+	// "x y" or "x,y", return number of chars written
+	int pos = formatFixed(dest, p->x);
+	dest[pos++] = sep;
+	pos += formatFixed(&dest[pos], p->y);
+	return pos;
+}
+
+int writeOutput(FILE * fout, char * buf, int len, char * caller) {
+	if(fwrite(buf, 1, len, fout) != len) {
+		printf("\nfwrite failed (%s)\n", caller);
+		return 1;
+	}
+	return 0;
+}
+
 //----------------------------------------------------------------------------
 //  SVG OUTPUT - GLOBAL VARIABLES AND FUNCTIONS
 //----------------------------------------------------------------------------
@@ -142,24 +218,21 @@ int dumpSVGHeader(FILE * fout, struct BIN_HEADER_S * header) {
 
 int dumpSVGStartPath(FILE * fout, struct BIN_POINT * p) {
 	if(!svgdump) return 0;
-	char base[20] = "";
+	char buf[64] = "";
+	int pos;
 	if(svgDumpState == DUMPSTATE_AFTER_CLOSE_PATH || svgDumpState == DUMPSTATE_AFTER_LINE) {
-		sprintf(base,"%s","M ");
+		pos = sprintf(buf,"%s","M ");
 	}	
 	else if(svgDumpState != DUMPSTATE_AFTER_HEADER && svgDumpState != DUMPSTATE_AFTER_END_PATH) {
 		printf("\nInvalid state in dumpSVGStartPath: %d\n",svgDumpState);
 		return 1;
 	} else {
-		sprintf(base,"%s","<path d=\"M ");
+		pos = sprintf(buf,"%s","<path d=\"M ");
 	}
 		
-	int r = fprintf(fout, "%s" F_FLOAT_FORMAT " " F_FLOAT_FORMAT " ",
-		base,
-		(double)p->x/(double)scaleFactor,
-		(double)p->y/(double)scaleFactor);
-	//
-	if(r < 0) {
-		printf("\nfprintf failed (dumpSVGStartPath)\n");
+	pos += formatPoint(&buf[pos], p, ' ');
+	buf[pos++] = ' ';
+	if(writeOutput(fout, buf, pos, "dumpSVGStartPath")) {
 		return 1;
 	}	
 	svgDumpState = DUMPSTATE_AFTER_START_PATH;
@@ -172,13 +245,14 @@ int dumpSVGCubic(FILE * fout, struct BIN_CUBIC * c) {
 		printf("\nInvalid state in dumpSVGCubic: %d\n",svgDumpState);
 		return 1;
 	}
-	int r = fprintf(fout, "C " F_FLOAT_FORMAT " " F_FLOAT_FORMAT ", " F_FLOAT_FORMAT " " F_FLOAT_FORMAT ", " F_FLOAT_FORMAT " " F_FLOAT_FORMAT " ", 
-		(double)c->p[0].x/(double)scaleFactor, (double)c->p[0].y/(double)scaleFactor,
-		(double)c->p[1].x/(double)scaleFactor, (double)c->p[1].y/(double)scaleFactor,
-		(double)c->p[2].x/(double)scaleFactor, (double)c->p[2].y/(double)scaleFactor);
-	//
-	if(r < 0) {
-		printf("\nfprintf failed (dumpSVGCubic)\n");
+	char buf[128] = "C ";
+	int pos = 2;
+	for(int i=0; i<3; i++) {
+		pos += formatPoint(&buf[pos], &c->p[i], ' ');
+		if(i<2) buf[pos++] = ',';
+		buf[pos++] = ' ';
+	}
+	if(writeOutput(fout, buf, pos, "dumpSVGCubic")) {
 		return 1;
 	}		
 	svgDumpState = DUMPSTATE_AFTER_LINE;
@@ -191,9 +265,11 @@ int dumpSVGLine(FILE * fout, struct BIN_POINT * p) {
 		printf("\nInvalid state in dumpSVGLine: %d\n",svgDumpState);
 		return 1;
 	}
-	int r = fprintf(fout, "L " F_FLOAT_FORMAT " " F_FLOAT_FORMAT " ", (double)p->x/(double)scaleFactor, (double)p->y/(double)scaleFactor);
-	if(r < 0) {
-		printf("\nfprintf failed (dumpSVGLine)\n");
+	char buf[64] = "L ";
+	int pos = 2;
+	pos += formatPoint(&buf[pos], p, ' ');
+	buf[pos++] = ' ';
+	if(writeOutput(fout, buf, pos, "dumpSVGLine")) {
 		return 1;
 	}			
 	svgDumpState = DUMPSTATE_AFTER_LINE;
@@ -231,9 +307,11 @@ int dumpSVGEndPath(FILE * fout, int hasFill, struct BIN_COLOR * fillColor, int h
 	}
 	
 	if(hasStroke) { 
-		sprintf(strokeBuf,"stroke=\"rgb(%u,%u,%u)\" stroke-width=\"" F_FLOAT_FORMAT "\" stroke-linecap=\"butt\" stroke-linejoin=\"miter\" stroke-miterlimit=\"10\" ",
+		char widthBuf[20];
+		formatFixed(widthBuf, strokeWidth);
+		sprintf(strokeBuf,"stroke=\"rgb(%u,%u,%u)\" stroke-width=\"%s\" stroke-linecap=\"butt\" stroke-linejoin=\"miter\" stroke-miterlimit=\"10\" ",
 			strokeColor->r, strokeColor->g, strokeColor->b,
-			(double)strokeWidth/(double)scaleFactor
+			widthBuf
 		);
 	}
 	
@@ -313,6 +391,143 @@ int dumpSVGSetViewbox(FILE * fout, int32_t minx, int32_t miny, int32_t maxx, int
 	return 0;
 }
 
+//----------------------------------------------------------------------------
+//  JSON-LINES OUTPUT - GLOBAL VARIABLES AND FUNCTIONS
+//----------------------------------------------------------------------------
+
+/*	One JSON object per path, one path per line, e.g.
+	{"layer":0,"d":[["M",x,y],["L",x,y],["C",x1,y1,x2,y2,x,y],["Z"]],
+	 "fill":[r,g,b],"stroke":[r,g,b],"strokeWidth":w}
+	fill, stroke and strokeWidth are null when not present.
+	A type 2 command file is a single layer, so layer is always 0 (vecass assembles the layers).
+	Coordinates are fixed decimals, identical to those in the svg output. */
+
+int jsondump = 0;
+
+enum SVGDUMP_STATE jsonDumpState = 0;	// same states as the svg output
+
+int formatColorJSON(char * dest, int hasColor, struct BIN_COLOR * color) {
+	if(!hasColor) return sprintf(dest,"null");
+	return sprintf(dest,"[%u,%u,%u]",color->r,color->g,color->b);
+}
+
+int dumpJSONHeader(FILE * fout) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_BEGIN) {
+		printf("\nInvalid state in dumpJSONHeader: %d\n",jsonDumpState);
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_HEADER;
+	return 0;
+}
+
+int dumpJSONStartPath(FILE * fout, struct BIN_POINT * p) {
+	if(!jsondump) return 0;
+	char buf[128];
+	int pos;
+	if(jsonDumpState == DUMPSTATE_AFTER_CLOSE_PATH || jsonDumpState == DUMPSTATE_AFTER_LINE) {
+		pos = sprintf(buf,"%s",",[\"M\",");
+	}
+	else if(jsonDumpState != DUMPSTATE_AFTER_HEADER && jsonDumpState != DUMPSTATE_AFTER_END_PATH) {
+		printf("\nInvalid state in dumpJSONStartPath: %d\n",jsonDumpState);
+		return 1;
+	} else {
+		pos = sprintf(buf,"%s","{\"layer\":0,\"d\":[[\"M\",");
+	}
+	pos += formatPoint(&buf[pos], p, ',');
+	buf[pos++] = ']';
+	if(writeOutput(fout, buf, pos, "dumpJSONStartPath")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_START_PATH;
+	return 0;
+}
+
+int dumpJSONCubic(FILE * fout, struct BIN_CUBIC * c) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_START_PATH && jsonDumpState != DUMPSTATE_AFTER_LINE) {
+		printf("\nInvalid state in dumpJSONCubic: %d\n",jsonDumpState);
+		return 1;
+	}
+	char buf[128] = ",[\"C\"";
+	int pos = 5;
+	for(int i=0; i<3; i++) {
+		buf[pos++] = ',';
+		pos += formatPoint(&buf[pos], &c->p[i], ',');
+	}
+	buf[pos++] = ']';
+	if(writeOutput(fout, buf, pos, "dumpJSONCubic")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_LINE;
+	return 0;
+}
+
+int dumpJSONLine(FILE * fout, struct BIN_POINT * p) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_START_PATH && jsonDumpState != DUMPSTATE_AFTER_LINE) {
+		printf("\nInvalid state in dumpJSONLine: %d\n",jsonDumpState);
+		return 1;
+	}
+	char buf[64] = ",[\"L\",";
+	int pos = 6;
+	pos += formatPoint(&buf[pos], p, ',');
+	buf[pos++] = ']';
+	if(writeOutput(fout, buf, pos, "dumpJSONLine")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_LINE;
+	return 0;
+}
+
+int dumpJSONClosePath(FILE * fout) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_LINE && jsonDumpState != DUMPSTATE_AFTER_START_PATH) {
+		printf("\nInvalid state in dumpJSONClosePath: %d\n",jsonDumpState);
+		return 1;
+	}
+	if(writeOutput(fout, ",[\"Z\"]", 6, "dumpJSONClosePath")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_CLOSE_PATH;
+	return 0;
+}
+
+int dumpJSONEndPath(FILE * fout, int hasFill, struct BIN_COLOR * fillColor, int hasStroke, int32_t strokeWidth, struct BIN_COLOR * strokeColor) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_LINE && jsonDumpState != DUMPSTATE_AFTER_CLOSE_PATH) {
+		printf("\nInvalid state in dumpJSONEndPath: %d\n",jsonDumpState);
+		return 1;
+	}
+	char buf[128];
+	int pos = sprintf(buf,"%s","],\"fill\":");
+	pos += formatColorJSON(&buf[pos], hasFill, fillColor);
+	pos += sprintf(&buf[pos],"%s",",\"stroke\":");
+	pos += formatColorJSON(&buf[pos], hasStroke, strokeColor);
+	pos += sprintf(&buf[pos],"%s",",\"strokeWidth\":");
+	if(hasStroke) {
+		pos += formatFixed(&buf[pos], strokeWidth);
+	} else {
+		pos += sprintf(&buf[pos],"null");
+	}
+	pos += sprintf(&buf[pos],"%s","}\n");
+	if(writeOutput(fout, buf, pos, "dumpJSONEndPath")) {
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_END_PATH;
+	return 0;
+}
+
+int dumpJSONFooter(FILE * fout) {
+	if(!jsondump) return 0;
+	if(jsonDumpState != DUMPSTATE_AFTER_END_PATH) {
+		printf("\nInvalid state in dumpJSONFooter: %d\n",jsonDumpState);
+		return 1;
+	}
+	jsonDumpState = DUMPSTATE_AFTER_FOOTER;
+	return 0;
+}
+
 //----------------------------------------------------------------------------
 //  BYTE ORDER FUNCTIONS
 //----------------------------------------------------------------------------
@@ -401,6 +616,30 @@ void printError2(char * str1, char * str2) {
 	printf("  error : %s%s\n", str1, str2);
 }
 
+int makeAutoFilename(char * dest, int destSize, char * source, char * ext) {
+	// Replace a short trailing extension of source (if any) with ext, e.g. ".svg"
+	if(strlen(source)+1 > destSize) return 1;
+	strcpy(dest, source);
+	// remove common trailing extensions for common file names
+	int s = strlen(dest);
+	if(s>5) {
+		int dotPos=-1;
+		for(int i=s-5; i<s; i++) {
+			if(dest[i]=='/' || dest[i]=='\\') dotPos=-1;
+			else if(dest[i]=='.') dotPos=i;
+		}
+		if(dotPos != -1) {
+			dest[dotPos] = 0;
+		}
+	}
+	s = strlen(dest);
+	if((s+strlen(ext)+1) < destSize) {
+		strcpy(&dest[s],ext);
+		return 0;
+	}
+	return 1;
+}
+
 //----------------------------------------------------------------------------
 //  MAIN
 //----------------------------------------------------------------------------
@@ -409,11 +648,12 @@ int main(int argc, char * argv[]) {
     
     if(argc<3) {
 		printf("%s","ubvff2: Unknown Binary Vector File Format Type 2, analyser and SVG converter\n\n");
-		printf("%s","usage: ubvff2 cmdFile pointsFile [-svgdump outputFile] [-more] [-less]\n"
+		printf("%s","usage: ubvff2 cmdFile pointsFile [-svgdump outputFile] [-jsondump outputFile] [-more] [-less]\n"
 					"    cmdFile       File name of input file that contains vector commands.\n"
 					"    pointsFile    File name of input file that contains point data.\n"
 					"                  Can be \"auto\" to guess \"NNNNN.bin\" e.g. \"00123.bin\".\n"
 					"    -svgdump      Create an svg file. File name can be \"auto\".\n"
+					"    -jsondump     Create a JSON-lines file, one path per line. File name can be \"auto\".\n"
 					"    -more         Display more analysis information.\n"
 					"    -less         Display less analysis information.\n"
 		);			
@@ -423,6 +663,7 @@ int main(int argc, char * argv[]) {
 	char * filename1 = argv[1];
 	char filename2[300];
 	char svgfilename[300];
+	char jsonfilename[300];
 	int detail = 2;					// 1:little, 2:one line per command, 3:all 
 	uint32_t offset = 4;
 	
@@ -447,6 +688,14 @@ int main(int argc, char * argv[]) {
 				return 1;
 			}
 			strcpy(svgfilename,argv[i]);
+		} else if(strncmp(argv[i],"-jsondump",9)==0 && i<(argc-1)) {
+			jsondump = 1;
+			i++;
+			if((strlen(argv[i])+1) > sizeof(jsonfilename)) {
+				printError("json outputFile name is too long");
+				return 1;
+			}
+			strcpy(jsonfilename,argv[i]);
 		} else if(strncmp(argv[i],"-more",5)==0) {
 			detail++;
 		} else if(strncmp(argv[i],"-less",5)==0) {
@@ -463,24 +712,16 @@ int main(int argc, char * argv[]) {
     fseek(fin1,0,SEEK_SET);
 
 	// come up with auto svg filename
-	if(memcmp(svgfilename,"auto",5)==0) {
-		strcpy(svgfilename, filename1);
-		// remove common trailing extensions for common file names
-		int s = strlen(svgfilename);
-		if(s>5) {
-			int dotPos=-1;
-			for(int i=s-5; i<s; i++) {
-				if(svgfilename[i]=='/' || svgfilename[i]=='\\') dotPos=-1;
-				else if(svgfilename[i]=='.') dotPos=i;
-			}
-			if(dotPos != -1) {
-				svgfilename[dotPos] = 0;
-			}
+	if(svgdump && memcmp(svgfilename,"auto",5)==0) {
+		if(makeAutoFilename(svgfilename, sizeof(svgfilename), filename1, ".svg")) {
+			printError("auto filename is too long!");
+			return 1;
 		}
-		s = strlen(svgfilename);
-		if((s+5) < sizeof(svgfilename)) {
-			memcpy(&svgfilename[s],".svg",5);
-		} else {
+	}
+
+	// come up with auto json filename
+	if(jsondump && memcmp(jsonfilename,"auto",5)==0) {
+		if(makeAutoFilename(jsonfilename, sizeof(jsonfilename), filename1, ".jsonl")) {
 			printError("auto filename is too long!");
 			return 1;
 		}
@@ -577,11 +818,25 @@ int main(int argc, char * argv[]) {
 			printError2("unable to open output file: ", svgfilename);
 			return 1;
 		}
+		setOutputBuffer(fout);
 		printf("svg output file               : %s\n", svgfilename);
 	}
+
+	FILE * jout = NULL;
+	if(jsondump) {
+		// Open output file
+		jout = fopen(jsonfilename,"wb");
+		if(jout==NULL) {
+			printError2("unable to open output file: ", jsonfilename);
+			return 1;
+		}
+		setOutputBuffer(jout);
+		printf("json output file              : %s\n", jsonfilename);
+	}
 	
 	// SVG: output the header
 	dumpSVGHeader(fout, &header.params);
+	dumpJSONHeader(jout);
 	
 	// Seek to the start of the command data
 	fseek(fin1,14,SEEK_SET);
@@ -616,6 +871,7 @@ int main(int argc, char * argv[]) {
 		// Process parameters
 		if(cmd==0x01) {						// END_FILE
 			dumpSVGFooter(fout);
+			dumpJSONFooter(jout);
 			dumpSVGSetViewbox(fout,viewMinX,viewMinY,viewMaxX,viewMaxY);
 			cmdCounter++;
 			if(detail >= 2) {
@@ -639,7 +895,7 @@ int main(int argc, char * argv[]) {
 				printFloat(p.y);
 				printf("\n");
 			}
-			if(dumpSVGStartPath(fout,&p)) {
+			if(dumpSVGStartPath(fout,&p) || dumpJSONStartPath(jout,&p)) {
 				break;
 			}
 		} else if(cmd==0x03) {				// POINTS_LINES
@@ -664,7 +920,7 @@ int main(int argc, char * argv[]) {
 				printf("%u lines\n", pTotal);
 			}
 			for(int i=0; i<pTotal; i++) {
-				if(dumpSVGLine(fout, &points[i])) {
+				if(dumpSVGLine(fout, &points[i]) || dumpJSONLine(jout, &points[i])) {
 					break;
 				}
 			}
@@ -692,7 +948,7 @@ int main(int argc, char * argv[]) {
 				printf("%u cubics\n", pTotal/3);
 			}
 			for(int i=0; i<(pTotal/3); i++) {
-				if(dumpSVGCubic(fout, &cubics[i])) {
+				if(dumpSVGCubic(fout, &cubics[i]) || dumpJSONCubic(jout, &cubics[i])) {
 					break;
 				}
 			}
@@ -714,12 +970,14 @@ int main(int argc, char * argv[]) {
 			}
 			if(cmdw.words[1] == 0x01) {		
 				dumpSVGClosePath(fout);				// Close the path ('Z')
+				dumpJSONClosePath(jout);
 				hasStroke = 0;
 				hasFill = 1;
 			} else if(cmdw.words[1] == 0x00) {		// Has stroke
 				hasStroke = 1;
 			} else if(cmdw.words[1] == 0x02) {		// End the path.
 				dumpSVGEndPath(fout,hasFill,&fillColor,hasStroke,strokeWidth,&strokeColor);
+				dumpJSONEndPath(jout,hasFill,&fillColor,hasStroke,strokeWidth,&strokeColor);
 			} else if(cmdw.words[1] == 0x03) {		// Has NO stroke or fill.
 				hasFill = 0;
 			} else if(cmdw.words[1] == 0x04) {
@@ -773,6 +1031,10 @@ int main(int argc, char * argv[]) {
 		}
 	}
 
+	if(jsondump && jsonDumpState!=DUMPSTATE_AFTER_FOOTER) {
+		error = 1;
+	}
+
 	if(cmdCounter != header.params.cmdCount) {
 		printf("warning : cmdCounter got to %u of %u\n",cmdCounter,header.params.cmdCount);
 		error = 1;
@@ -781,7 +1043,16 @@ int main(int argc, char * argv[]) {
 	fclose(fin1);
 	fclose(fin2);
 	if(svgdump) {
-		fclose(fout);
+		if(fclose(fout) != 0) {			// output is buffered, so write errors may only show up here
+			printError("failed writing svg output file");
+			error = 1;
+		}
+	}
+	if(jsondump) {
+		if(fclose(jout) != 0) {
+			printError("failed writing json output file");
+			error = 1;
+		}
 	}
 	
 	if(error) {